@@ -304,28 +304,28 @@ static uint8_t set_shadow(uint32_t left_angle, uint32_t right_angle,
 
 /* Test whether angle between "left_angle" and "right_angle", or at least
  * "middle_angle", is captured inside one of the shadow angles in "shadows". If
- * so, set hex in "fov_map" indexed by "pos_in_map" to 'H'. If the whole angle
- * and not just "middle_angle" is captured, return 1. Any other case: 0.
+ * so, set FOV map cell "fov_cell" to 'H'. If the whole angle and not just
+ * "middle_angle" is captured, return 1. Any other case: 0.
  */
 static uint8_t shade_hex(uint32_t left_angle, uint32_t right_angle,
                          uint32_t middle_angle, struct shadow_angle ** shadows,
-                         uint16_t pos_in_map, char * fov_map)
+                         char * fov_cell)
 {
     struct shadow_angle * shadow_i;
-    if (fov_map[pos_in_map] == 'v')
+    if (*fov_cell == 'v')
     {
         for (shadow_i = *shadows; shadow_i; shadow_i = shadow_i->next)
         {
             if (   left_angle <=  shadow_i->left_angle
                 && right_angle >= shadow_i->right_angle)
             {
-                fov_map[pos_in_map] = 'H';
+                *fov_cell = 'H';
                 return 1;
             }
             if (   middle_angle < shadow_i->left_angle
                 && middle_angle > shadow_i->right_angle)
             {
-                fov_map[pos_in_map] = 'H';
+                *fov_cell = 'H';
             }
         }
     }
@@ -334,11 +334,11 @@ static uint8_t shade_hex(uint32_t left_angle, uint32_t right_angle,
 
 /* Evaluate map position "test_pos" in distance "dist" to the view origin, and
  * on the circle of that distance to the origin on hex "hex_i" (as counted from
- * the circle's rightmost point), for setting shaded hexes in "fov_map" and
+ * the circle's rightmost point), for shading its FOV map cell "fov_cell" and
  * potentially adding a new shadow to linked shadow angle list "shadows".
  * Return 1 on malloc error, else 0.
  */
-static uint8_t eval_position(uint16_t dist, uint16_t hex_i, char * fov_map,
+static uint8_t eval_position(uint16_t dist, uint16_t hex_i, char * fov_cell,
                              struct yx_uint8 * test_pos,
                              struct shadow_angle ** shadows,
                              const char * symbols_obstacle)
@@ -357,7 +357,7 @@ static uint8_t eval_position(uint16_t dist, uint16_t hex_i, char * fov_map,
     }
     uint16_t pos_in_map = test_pos->y * maplength + test_pos->x;
     uint8_t all_shaded = shade_hex(left_angle, right_angle_1st, middle_angle,
-                                   shadows, pos_in_map, fov_map);
+                                   shadows, fov_cell);
     if (!all_shaded && NULL != strchr(symbols_obstacle, worldmap[pos_in_map]))
     {
         if (set_shadow(left_angle, right_angle_1st, shadows))
@@ -410,8 +410,9 @@ extern uint8_t build_fov_map(uint8_t y, uint8_t x, char * fovmap,
             }
             if (mv_yx_in_dir_legal(dir_char, &test_pos))
             {
-                if (eval_position(circle_i, hex_i, fovmap, &test_pos, &shadows,
-                                  symbols_obstacle))
+                char * fov_cell = fovmap + test_pos.y * maplength + test_pos.x;
+                if (eval_position(circle_i, hex_i, fov_cell, &test_pos,
+                                  &shadows, symbols_obstacle))
                 {
                     return 1;
                 }
@@ -424,6 +425,231 @@ extern uint8_t build_fov_map(uint8_t y, uint8_t x, char * fovmap,
     return 0;
 }
 
+/* Axial hex coordinate, unbounded by map or wrap space limits. "q" grows
+ * eastward along a row, "r" is the row, so that moving south-east keeps "q".
+ */
+struct qr_int32
+{
+    int32_t q;
+    int32_t r;
+};
+
+/* Axial steps for the hex directions in "xswedc", i.e. the order in which the
+ * segments of an FOV circle are walked by build_fov_map(), and for the corners
+ * those segments start from: east, south-east, south-west etc.
+ */
+static const int8_t segment_steps[6][2] = {{-1,1},{-1,0},{0,-1},{1,-1},{1,0},
+                                           {0,1}};
+static const int8_t corner_steps[6][2] = {{1,0},{0,1},{-1,1},{-1,0},{0,-1},
+                                          {1,-1}};
+
+/* Return axial coordinate of map position "y"/"x". */
+static struct qr_int32 yx_to_qr(int32_t y, int32_t x)
+{
+    struct qr_int32 qr;
+    qr.q = x - ((y - (y & 1)) / 2);
+    qr.r = y;
+    return qr;
+}
+
+/* Write into "pos" hex "hex_i" on FOV circle "dist" around "center", counted
+ * the way build_fov_map() walks it: clockwise from the circle's rightmost hex.
+ * Return 1 if "pos" ends up on the map (and in its original wrap space, which
+ * is what mv_yx_in_dir_legal() demands of build_fov_map()'s walk), else 0.
+ */
+static uint8_t circle_hex_to_yx(struct qr_int32 center, uint16_t dist,
+                                uint16_t hex_i, struct yx_uint8 * pos)
+{
+    uint8_t seg = hex_i / dist;
+    uint16_t step = hex_i % dist;
+    int32_t q =   center.q + (dist * corner_steps[seg][0])
+                + (step * segment_steps[seg][0]);
+    int32_t r =   center.r + (dist * corner_steps[seg][1])
+                + (step * segment_steps[seg][1]);
+    int32_t x = q + ((r - (r & 1)) / 2);
+    if (r < 0 || x < 0 || r >= maplength || x >= maplength)
+    {
+        return 0;
+    }
+    pos->y = r;
+    pos->x = x;
+    return 1;
+}
+
+/* Write into "dist" and "hex_i" the FOV circle and hex on it that map position
+ * "y"/"x" is found on as seen from "center" (see circle_hex_to_yx()).
+ */
+static void yx_to_circle_hex(struct qr_int32 center, uint8_t y, uint8_t x,
+                             uint16_t * dist, uint16_t * hex_i)
+{
+    struct qr_int32 qr = yx_to_qr(y, x);
+    int32_t dq = qr.q - center.q;
+    int32_t dr = qr.r - center.r;
+    *dist = (abs(dq) + abs(dr) + abs(dq + dr)) / 2;
+    *hex_i = 0;
+    uint8_t seg;
+    for (seg = 0; seg < 6; seg++)
+    {
+        int32_t q = dq - *dist * corner_steps[seg][0];
+        int32_t r = dr - *dist * corner_steps[seg][1];
+        int32_t step = segment_steps[seg][0] ? q / segment_steps[seg][0]
+                                             : r / segment_steps[seg][1];
+        if (   step >= 0 && step < *dist
+            && q == step * segment_steps[seg][0]
+            && r == step * segment_steps[seg][1])
+        {
+            *hex_i = seg * *dist + step;
+            return;
+        }
+    }
+}
+
+/* Run eval_position() on the hexes "from" to "to" of FOV circle "dist" around
+ * "center" that lie on the map, in the order build_fov_map() would, writing
+ * their FOV state to a scratch cell; only hex "target_i" (if on this circle)
+ * writes to "fov_cell".
+ * Return 1 on malloc error, else 0.
+ */
+static uint8_t eval_circle_span(struct qr_int32 center, uint16_t dist,
+                                uint16_t from, uint16_t to, uint16_t target_i,
+                                char * fov_cell, struct shadow_angle ** shadows,
+                                const char * symbols_obstacle)
+{
+    uint16_t hex_i;
+    for (hex_i = from; hex_i <= to; hex_i++)
+    {
+        struct yx_uint8 test_pos;
+        if (circle_hex_to_yx(center, dist, hex_i, &test_pos))
+        {
+            char scratch_cell = 'v';
+            char * cell = hex_i == target_i ? fov_cell : &scratch_cell;
+            if (eval_position(dist, hex_i, cell, &test_pos, shadows,
+                              symbols_obstacle))
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Set "fov_cell" to 'H' if map position "y2"/"x2" would be shaded in the FOV
+ * map build_fov_map() builds from "y1"/"x1", else leave it as it is ('v').
+ * Instead of all circles over the whole map, only walk the wedge of each inner
+ * circle that angles onto the target hex, plus a safety margin of a few hexes
+ * on both sides to catch shadows merging into it. Return 1 on malloc error,
+ * else 0.
+ */
+static uint8_t trace_los(uint8_t y1, uint8_t x1, uint8_t y2, uint8_t x2,
+                         char * fov_cell, const char * symbols_obstacle)
+{
+    struct qr_int32 center = yx_to_qr(y1, x1);
+    uint16_t target_dist, target_i;
+    yx_to_circle_hex(center, y2, x2, &target_dist, &target_i);
+    if (!target_dist)
+    {
+        return 0;
+    }
+    int32_t target_left =   ((CIRCLE / 12) / target_dist)
+                          - (target_i * (CIRCLE / 6) / target_dist);
+    int32_t target_right = target_left - (CIRCLE / (6 * target_dist));
+    struct shadow_angle * shadows = NULL;
+    uint8_t malloc_error = 0;
+    uint16_t dist;
+    for (dist = 1; dist <= target_dist && !malloc_error; dist++)
+    {
+        int32_t circle_size = 6 * dist;
+        int32_t hex_width = CIRCLE / circle_size;
+        int32_t first_left = (CIRCLE / 12) / dist;
+        int32_t wedge_from = ((first_left - target_left) / hex_width) - 2;
+        int32_t wedge_to   = ((first_left - target_right) / hex_width) + 2;
+        uint16_t last = circle_size - 1;
+        uint16_t circle_target_i = UINT16_MAX;
+        if (dist == target_dist)
+        {
+            last = circle_target_i = target_i;
+        }
+        uint16_t spans[2][2] = {{1, 0}, {1, 0}};   /* Empty unless set below. */
+        if (wedge_to - wedge_from + 1 >= circle_size)
+        {
+            spans[0][0] = 0;
+            spans[0][1] = last;
+        }
+        else
+        {
+            uint16_t from = (wedge_from + circle_size) % circle_size;
+            uint16_t to   = (wedge_to   + circle_size) % circle_size;
+            if (from <= to)
+            {
+                spans[0][0] = from;
+                spans[0][1] = to < last ? to : last;
+            }
+            else                                  /* Wedge wraps around the */
+            {                                     /* circle's rightmost hex.*/
+                spans[0][0] = 0;
+                spans[0][1] = to < last ? to : last;
+                spans[1][0] = from;
+                spans[1][1] = last;
+            }
+        }
+        uint8_t i;
+        for (i = 0; i < 2 && !malloc_error; i++)
+        {
+            if (spans[i][0] <= spans[i][1])
+            {
+                malloc_error = eval_circle_span(center, dist, spans[i][0],
+                                                spans[i][1], circle_target_i,
+                                                fov_cell, &shadows,
+                                                symbols_obstacle);
+            }
+        }
+    }
+    if (shadows)
+    {
+        free_angles(shadows);
+    }
+    return malloc_error;
+}
+
+/* Return 1 if map position "y2"/"x2" is visible from "y1"/"x1" in the sense of
+ * build_fov_map() on "worldmap_input" (i.e. would be 'v' in its FOV map), 0 if
+ * not, and -1 on malloc error.
+ */
+extern int8_t los(uint8_t y1, uint8_t x1, uint8_t y2, uint8_t x2,
+                  char * worldmap_input, const char * symbols_obstacle)
+{
+    worldmap = worldmap_input;
+    char fov_cell = 'v';
+    if (trace_los(y1, x1, y2, x2, &fov_cell, symbols_obstacle))
+    {
+        return -1;
+    }
+    return 'v' == fov_cell;
+}
+
+/* For each of the "n_targets" map positions (array indices) in "targets", set
+ * the same-indexed cell of "results" to what build_fov_map() from "y"/"x"
+ * would have set it to in its FOV map: 'v' if visible, else 'H'. Return 1 on
+ * malloc error, else 0.
+ */
+extern uint8_t los_many(uint8_t y, uint8_t x, uint16_t n_targets,
+                        const uint16_t * targets, char * results,
+                        char * worldmap_input, const char * symbols_obstacle)
+{
+    worldmap = worldmap_input;
+    uint16_t i;
+    for (i = 0; i < n_targets; i++)
+    {
+        results[i] = 'v';
+        if (trace_los(y, x, targets[i] / maplength, targets[i] % maplength,
+                      results + i, symbols_obstacle))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 static uint16_t * score_map = NULL;
 static uint16_t neighbor_scores[6];
 
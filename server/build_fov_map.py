@@ -13,3 +13,30 @@ def build_fov_map(t):
     hide_string = c_pointer_to_string(symbols_hide)
     if libpr.build_fov_map(t["T_POSY"], t["T_POSX"], fovmap, m, hide_string):
         raise RuntimeError("Malloc error in build_fov_Map().")
+
+
+def los(y1, x1, y2, x2):
+    """Return whether y2/x2 is visible from y1/x1, as per build_fov_map()."""
+    from server.config.world_data import world_db, symbols_hide
+    from server.utils import libpr, c_pointer_to_bytearray, c_pointer_to_string
+    m = c_pointer_to_bytearray(world_db["MAP"])
+    hide_string = c_pointer_to_string(symbols_hide)
+    result = libpr.los(y1, x1, y2, x2, m, hide_string)
+    if -1 == result:
+        raise RuntimeError("Malloc error in los().")
+    return 1 == result
+
+
+def los_many(y, x, positions):
+    """Return "v" (visible) or "H" from y/x for each map index in positions."""
+    import ctypes
+    from server.config.world_data import world_db, symbols_hide
+    from server.utils import libpr, c_pointer_to_bytearray, c_pointer_to_string
+    targets = (ctypes.c_uint16 * len(positions))(*positions)
+    results = bytearray(b' ' * len(positions))
+    m = c_pointer_to_bytearray(world_db["MAP"])
+    hide_string = c_pointer_to_string(symbols_hide)
+    if libpr.los_many(y, x, len(positions), targets,
+                      c_pointer_to_bytearray(results), m, hide_string):
+        raise RuntimeError("Malloc error in los_many().")
+    return [chr(c) for c in results]
@@ -79,6 +79,7 @@ def prep_library():
         raise SystemExit("No library " + libpath + ", run ./build.sh first?")
     libpr = ctypes.cdll.LoadLibrary(libpath)
     libpr.seed_rrand.restype = ctypes.c_uint32
+    libpr.los.restype = ctypes.c_int8
     return libpr
 
 